@@ -41,6 +41,11 @@ int main() {
 
 	dgPointer->solveShortestPath(7,1);
 
+	//everything within 2 hops of H, following arcs in both directions
+	digraph<char> *neighborhood = dgPointer->extractNeighborhood(7, 2, true);
+	neighborhood->printGraph();
+	delete neighborhood;
+
 	return 0;
 
 }
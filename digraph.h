@@ -33,11 +33,13 @@ using namespace std;
 #include <list>
 #include <vector>
 #include <queue>
+#include <utility>
 
 template <typename elementType>
 class digraph {
 public:
 	digraph();
+	~digraph(); //frees the arcs of all nodes
 	int addNode(elementType data); //return index of the added node
 	//following 4 functions raise exceptions if nodeIndex is not in the list.
 	void removeNode(int nodeIndex);
@@ -46,7 +48,13 @@ public:
 	void removeArcW(int srcNodeIndex, int dstNodeIndex, int weight=0); //remove an arc from "srcNode" whose weight is equal to weight
 	void printGraph(); //TODO: move this to << operator later
 	void solveShortestPath(int beginNode, int endNode);
+	//copy every node within hops arcs of centerNode (and the arcs between them) into a new digraph, caller deletes it
+	//not reentrant: it uses scratch space in the graph, so calls on the same graph must not overlap (not thread-safe)
+	digraph<elementType>* extractNeighborhood(int centerNode, int hops, bool followInArcs=false);
 private:
+	//copying would share the arcLink chains and the destructor would free them twice, so no copies
+	digraph(const digraph<elementType>& other);
+	digraph<elementType>& operator=(const digraph<elementType>& other);
 	class dgNode {
 	public:
 		dgNode(elementType data, int index);
@@ -57,10 +65,12 @@ private:
 		void removeArcW(dgNode* adjNode, int weight=1); //same as above but also check weight
 		void removeArcsToThis(); //remove all arcs coming to node from other nodes
 		void removeArcsFromThis(); //remove all arcs sent from this node and their references on respective nodes
+		void deleteArcLists(); //free both linked lists without touching other nodes, only for destroying the whole graph
 		int getNumArcs();
 		int getNumArcsFrom();
 		void getArcToList(dgNode** arcList); //take and fill an array with all dgNode's the node arcs to
 		void getArcFromList(vector<dgNode*> *arcList); //take and fill an array with all dgNode's the node arcs to
+		void getArcToWeightList(vector<pair<dgNode*, int> > *arcList); //fill a vector with (destination node, weight) of every outgoing arc
 		inline void setIndex(int index) {this->index = index;}
 		inline int getIndex() {return this->index;}
 		elementType getData();
@@ -87,6 +97,7 @@ private:
 			inline int getIndex() {return this->index;}
 			inline int getWeight() {return this->weight;}
 			inline arcLink *getNextLink() {return this->nextLink;}
+			inline void cutNextLink() {this->nextLink = 0;} //detach from the rest of the list, so the destructor won't walk it
 			//must define << here, other places are "non-deducible context" according to compiler
 			friend ostream& operator<<(ostream& os, digraph<elementType>::dgNode::arcLink& firstLink) {
 				arcLink *temp = &firstLink;
@@ -113,6 +124,10 @@ private:
 	};
 	list<dgNode> nodeList;
 	vector<dgNode*> indexList; //holds pointers to nodes so that we can access them randomly via their indices
+	//scratch space for extractNeighborhood, kept between calls so we don't allocate graph sized arrays every time
+	vector<unsigned int> visitStamp; //a node is visited in this call if its stamp equals visitGeneration
+	vector<int> visitLocal; //index of the visited node in the extracted graph, only valid if the stamp matches
+	unsigned int visitGeneration; //bumped on every call, so old stamps become stale without clearing the array
 };
 
 /*
@@ -384,6 +399,34 @@ void digraph<elementType>::dgNode::removeArcsFromThis() {
 	}
 }
 
+/*
+ * free the outgoing and incoming arc lists of this node
+ * It doesn't fix the lists on the other side, so use it only when every node is going away
+ * (it is not a destructor because nodeList holds copies of temporary dgNode objects)
+ * Each link is cut from the list before deletion, or else ~arcLink would walk (and renumber) the rest of it.
+ */
+template <typename elementType>
+void digraph<elementType>::dgNode::deleteArcLists() {
+	arcLink *temp, *next;
+	temp = firstArcToOther;
+	while(temp) {
+		next = temp->getNextLink();
+		temp->cutNextLink();
+		delete temp;
+		temp = next;
+	}
+	temp = topArcFromOther;
+	while(temp) {
+		next = temp->getNextLink();
+		temp->cutNextLink();
+		delete temp;
+		temp = next;
+	}
+	firstArcToOther = 0;
+	lastArcToOther = 0;
+	topArcFromOther = 0;
+}
+
 template <typename elementType>
 int digraph<elementType>::dgNode::getNumArcs() {
 	if(lastArcToOther == 0) return 0;
@@ -434,6 +477,16 @@ void digraph<elementType>::dgNode::getArcFromList(vector<digraph<elementType>::d
 	return;
 }
 
+template <typename elementType>
+void digraph<elementType>::dgNode::getArcToWeightList(vector<pair<digraph<elementType>::dgNode*, int> > *arcList) {
+	arcLink* temp = firstArcToOther; //unlike getArcToList this one is safe on nodes without arcs
+	while(temp) {
+		arcList->push_back(make_pair(temp->getNode(), temp->getWeight()));
+		temp = temp->getNextLink();
+	}
+	return;
+}
+
 template <typename elementType>
 elementType digraph<elementType>::dgNode::getData() {
 	return this->data;	//may be we should return a reference?
@@ -441,7 +494,13 @@ elementType digraph<elementType>::dgNode::getData() {
 
 template <typename elementType>
 digraph<elementType>::digraph() {
-	//do we really need a constructor?
+	visitGeneration = 0; //no stamps are handed out yet
+}
+
+template <typename elementType>
+digraph<elementType>::~digraph() {
+	typename list<dgNode>::iterator it;
+	for(it = nodeList.begin(); it!=nodeList.end(); it++) it->deleteArcLists();
 }
 
 template <typename elementType>
@@ -618,4 +677,86 @@ void digraph<elementType>::solveShortestPath(int beginNode, int endNode) {
 
 }
 
+/*
+ * k-hop neighborhood (ego network) of centerNode
+ * Does a breadth first search which stops hops arcs away from centerNode,
+ * following incoming arcs too if followInArcs is set. Every node found is
+ * copied into a new digraph (indices start from 0 in order of discovery, so
+ * centerNode becomes node 0) together with all arcs running between them.
+ *
+ * Visited nodes are marked with a generation stamp instead of a fresh
+ * vector<bool> sized to the whole graph, so apart from growing the stamp
+ * array when the graph grows, the cost depends only on the size of the
+ * neighborhood. The returned graph is allocated with new, delete it yourself.
+ * Because of the shared stamps it is not reentrant or thread-safe on the same graph.
+ */
+template <typename elementType>
+digraph<elementType>* digraph<elementType>::extractNeighborhood(int centerNode, int hops, bool followInArcs) {
+	if(centerNode < 0 || centerNode >= (int)indexList.size() || indexList[centerNode] == 0) {
+		cerr << "there is no node with index " << centerNode << endl;
+		return 0;
+	}
+	if(visitStamp.size() < indexList.size()) {
+		//only new nodes get a stamp of 0, old entries keep their values
+		visitStamp.resize(indexList.size(), 0);
+		visitLocal.resize(indexList.size(), 0);
+	}
+	visitGeneration++;
+	if(visitGeneration == 0) {
+		//counter wrapped around, stale stamps could look fresh now. Clear them once and start over
+		for(size_t i = 0; i < visitStamp.size(); i++) visitStamp[i] = 0;
+		visitGeneration = 1;
+	}
+
+	digraph<elementType> *subgraph = new digraph<elementType>();
+	vector<int> found; //original indices of found nodes, found[i] is node i in subgraph
+	vector<pair<dgNode*, int> > arcList; //reused for every node, so it only allocates when it has to grow
+	vector<dgNode*> fromList;
+
+	visitStamp[centerNode] = visitGeneration;
+	visitLocal[centerNode] = subgraph->addNode(indexList[centerNode]->getData());
+	found.push_back(centerNode);
+	//found doubles as the visit queue: nodes in [levelBegin, levelEnd) are at the same distance
+	size_t levelBegin = 0;
+	for(int distance = 0; distance < hops && levelBegin < found.size(); distance++) {
+		size_t levelEnd = found.size();
+		for(size_t i = levelBegin; i < levelEnd; i++) {
+			dgNode *visitNode = indexList[found[i]];
+			arcList.clear();
+			visitNode->getArcToWeightList(&arcList);
+			for(size_t j = 0; j < arcList.size(); j++) {
+				int adjIndex = arcList[j].first->getIndex();
+				if(visitStamp[adjIndex] != visitGeneration) {
+					visitStamp[adjIndex] = visitGeneration;
+					visitLocal[adjIndex] = subgraph->addNode(arcList[j].first->getData());
+					found.push_back(adjIndex);
+				}
+			}
+			if(!followInArcs) continue;
+			fromList.clear();
+			visitNode->getArcFromList(&fromList);
+			for(size_t j = 0; j < fromList.size(); j++) {
+				int adjIndex = fromList[j]->getIndex();
+				if(visitStamp[adjIndex] != visitGeneration) {
+					visitStamp[adjIndex] = visitGeneration;
+					visitLocal[adjIndex] = subgraph->addNode(fromList[j]->getData());
+					found.push_back(adjIndex);
+				}
+			}
+		}
+		levelBegin = levelEnd;
+	}
+
+	//now copy the arcs, looking at outgoing arcs only so that each arc is added once
+	for(size_t i = 0; i < found.size(); i++) {
+		arcList.clear();
+		indexList[found[i]]->getArcToWeightList(&arcList);
+		for(size_t j = 0; j < arcList.size(); j++) {
+			int dstIndex = arcList[j].first->getIndex();
+			if(visitStamp[dstIndex] == visitGeneration) subgraph->addArc(i, visitLocal[dstIndex], arcList[j].second);
+		}
+	}
+	return subgraph;
+}
+
 #endif /* DIGRAPH_H_ */